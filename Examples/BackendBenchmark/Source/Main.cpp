@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    Measures the cost of drawing SVGs made of solid paths through juce::Drawable
+    on each paint call compared to rendering them once through resvg and drawing
+    the rendered image. The results are printed as CSV, preceded by comment lines
+    describing the machine. Pass a file name to also write them to a file, e.g.
+
+        BackendBenchmark Results/<machine>.csv
+
+    The last comment line suggests a value for JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS,
+    see jb::SVGComplexity.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include <iostream>
+#include <map>
+
+// Creates an SVG with the given number of solid filled paths, each made of a few cubic curves
+static juce::String createSVGWithSolidPaths (int numPaths)
+{
+    juce::Random random (numPaths);
+
+    auto coordinate = [&random] { return juce::String (random.nextFloat() * 100.0f, 2); };
+
+    juce::String svg;
+    svg << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\" viewBox=\"0 0 100 100\">\n";
+
+    for (int i = 0; i < numPaths; ++i)
+    {
+        auto colour = juce::Colour (random.nextInt()).withAlpha (1.0f);
+
+        svg << "  <path fill=\"#" << colour.toDisplayString (false) << "\" d=\"M " << coordinate() << " " << coordinate();
+
+        for (int c = 0; c < 3; ++c)
+            svg << " C " << coordinate() << " " << coordinate() << " "
+                         << coordinate() << " " << coordinate() << " "
+                         << coordinate() << " " << coordinate();
+
+        svg << " Z\"/>\n";
+    }
+
+    svg << "</svg>\n";
+    return svg;
+}
+
+// The minimum number of paint calls a raster has to be drawn before the time spent rendering it pays off. Documents
+// below that are drawn as vectors, as they save the memory of the raster without a noticeable cost
+static constexpr double minBreakEvenPaints = 100.0;
+
+// Returns the average time in milliseconds a call of the function took
+template <typename Fn>
+static double measureMs (int numIterations, Fn&& fn)
+{
+    auto start = juce::Time::getMillisecondCounterHiRes();
+
+    for (int i = 0; i < numIterations; ++i)
+        fn();
+
+    return (juce::Time::getMillisecondCounterHiRes() - start) / numIterations;
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    constexpr int numIterations = 200;
+    const std::initializer_list<int> sizes { 32, 64, 128, 256 };
+    const std::initializer_list<int> numPathsToTest { 1, 2, 4, 8, 16, 32, 64, 128 };
+
+    juce::String results;
+
+    auto print = [&results] (const juce::String& line)
+    {
+        std::cout << line << std::endl;
+        results << line << "\n";
+    };
+
+    print ("# cpu: " + juce::SystemStats::getCpuModel() + ", " + juce::String (juce::SystemStats::getNumCpus()) + " cores, "
+           + juce::String (juce::SystemStats::getCpuSpeedInMegahertz()) + " MHz");
+    print ("# os: " + juce::SystemStats::getOperatingSystemName());
+    print ("# juce: " + juce::SystemStats::getJUCEVersion());
+    print ("size,numPaths,vectorPaintMs,rasterRenderMs,rasterPaintMs,rasterBytes,breakEvenPaints");
+
+    // The largest number of paths for which vectors are the better choice at all sizes
+    std::map<int, bool> vectorsPreferred;
+
+    for (auto numPaths : numPathsToTest)
+        vectorsPreferred[numPaths] = true;
+
+    for (auto size : sizes)
+    {
+        juce::Image canvas (juce::Image::ARGB, size, size, true);
+        juce::Graphics g (canvas);
+
+        const auto bounds = canvas.getBounds().toFloat();
+
+        for (auto numPaths : numPathsToTest)
+        {
+            auto svgText = createSVGWithSolidPaths (numPaths);
+            auto svgData = svgText.toRawUTF8();
+            auto svgSize = static_cast<int> (svgText.getNumBytesAsUTF8());
+
+            auto xml = juce::parseXML (svgText);
+            auto drawable = juce::Drawable::createFromSVG (*xml);
+
+            jb::Resvg::RenderTree tree;
+            tree.loadFromBinaryData (svgData, svgSize);
+
+            juce::Image image;
+
+            auto vectorPaintMs  = measureMs (numIterations, [&] { drawable->drawWithin (g, bounds, juce::RectanglePlacement::centred, 1.0f); });
+            auto rasterRenderMs = measureMs (numIterations, [&] { image = tree.render (bounds); });
+            auto rasterPaintMs  = measureMs (numIterations, [&] { g.drawImage (image, bounds, juce::RectanglePlacement::centred); });
+
+            auto rasterBytes = image.getWidth() * image.getHeight() * 4;
+
+            // The number of paint calls after which rendering once and blitting is cheaper than drawing the vectors
+            auto breakEvenPaints = vectorPaintMs > rasterPaintMs ? rasterRenderMs / (vectorPaintMs - rasterPaintMs) : -1.0;
+
+            print (juce::String (size) + "," + juce::String (numPaths) + ","
+                   + juce::String (vectorPaintMs) + "," + juce::String (rasterRenderMs) + "," + juce::String (rasterPaintMs) + ","
+                   + juce::String (rasterBytes) + "," + juce::String (breakEvenPaints));
+
+            if (breakEvenPaints >= 0.0 && breakEvenPaints < minBreakEvenPaints)
+                vectorsPreferred[numPaths] = false;
+        }
+    }
+
+    auto suggestedMaxNumShapes = 0;
+
+    for (auto numPaths : numPathsToTest)
+    {
+        if (! vectorsPreferred[numPaths])
+            break;
+
+        suggestedMaxNumShapes = numPaths;
+    }
+
+    print ("# suggested JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS: " + juce::String (suggestedMaxNumShapes));
+
+    if (argc > 1)
+    {
+        juce::File resultsFile (juce::File::getCurrentWorkingDirectory().getChildFile (argv[1]));
+        resultsFile.getParentDirectory().createDirectory();
+
+        if (! resultsFile.replaceWithText (results))
+        {
+            std::cerr << "Could not write " << resultsFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
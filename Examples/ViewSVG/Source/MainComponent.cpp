@@ -46,14 +46,17 @@ void MainComponent::filesDropped (const juce::StringArray& files, int, int)
 {
     juce::File newSVGFile (files[0]);
 
-    jb::Resvg::RenderTree tree;
+    auto newSVG = std::make_unique<jb::SVGComponent> (newSVGFile);
 
-    if (tree.loadFromFile (newSVGFile))
+    if (newSVG->isValid())
     {
         if (svg != nullptr)
             removeChildComponent (svg.get());
 
-        svg = std::make_unique<jb::SVGComponent> (std::move (tree));
+        svg = std::move (newSVG);
+
+        // Resizing the window re-renders the SVG, so show a quick preview while the full image renders in the background
+        svg->setProgressiveRendering (true);
 
         addAndMakeVisible (*svg);
 
@@ -0,0 +1,83 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * A RasterOwner that is a component. It implements the opt-in release of the rendered images while the component is
+ * hidden and decides when the component should render, so that all SVG components behave the same way.
+ */
+class ComponentRasterOwner : public RasterOwner
+{
+public:
+
+    /** Pass the component deriving from this class */
+    explicit ComponentRasterOwner (juce::Component& ownerComponent) : component (ownerComponent) {}
+
+    /**
+     * If enabled, the rendered images are released as soon as the component is hidden or completely clipped away by
+     * its parents and the SVG is rendered again on the next paint call. Saves memory for components in hidden tabs,
+     * collapsed panels or scrolled out of a viewport at the cost of rendering again when they become visible. The
+     * pixel buffers of the released images are freed as well instead of being kept for reuse.
+     */
+    void setReleasesRastersWhenHidden (bool shouldReleaseRastersWhenHidden)
+    {
+        if (! shouldReleaseRastersWhenHidden)
+        {
+            visibilityWatcher.reset();
+            return;
+        }
+
+        if (visibilityWatcher != nullptr)
+            return;
+
+        visibilityWatcher = std::make_unique<VisibilityWatcher> (component, [this] (bool isVisible)
+        {
+            if (! isVisible)
+                releaseRastersAndBuffers();
+        });
+
+        if (! VisibilityWatcher::isVisibleOnScreen (component))
+            releaseRastersAndBuffers();
+    }
+
+    /** Returns true if the rendered images are released when the component is hidden */
+    bool releasesRastersWhenHidden() const
+    {
+        return visibilityWatcher != nullptr;
+    }
+
+protected:
+
+    /**
+     * Returns true if the component should render its images now. Rendering is deferred while the component is not
+     * showing, so that SVGPrewarmer can collect it, and while it is clipped away if it releases its rasters when
+     * hidden. Paint calls need the images in any case and pass renderEvenIfHidden.
+     */
+    bool shouldRender (bool renderEvenIfHidden) const
+    {
+        if (renderEvenIfHidden)
+            return true;
+
+        if (! component.isShowing())
+            return false;
+
+        return visibilityWatcher == nullptr || VisibilityWatcher::isVisibleOnScreen (component);
+    }
+
+private:
+
+    juce::Component& component;
+    std::unique_ptr<VisibilityWatcher> visibilityWatcher;
+
+    JUCE_DECLARE_NON_COPYABLE (ComponentRasterOwner)
+};
+
+}
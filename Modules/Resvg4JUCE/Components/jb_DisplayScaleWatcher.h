@@ -0,0 +1,168 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * Keeps track of the effective scale a component is displayed at, that is the scale of the display it is located on
+ * multiplied by all transforms applied to the component and its parents. It listens for peer changes, native scale
+ * factor changes and for the window being moved to another display and invokes a callback whenever the effective
+ * scale has changed.
+ */
+class DisplayScaleWatcher : private juce::ComponentMovementWatcher,
+                            private juce::ComponentPeer::ScaleFactorListener
+{
+public:
+
+    /** Starts watching the component. The callback is invoked on the message thread after the scale has changed */
+    DisplayScaleWatcher (juce::Component& componentToWatch, std::function<void()> scaleChangedCallback)
+      : juce::ComponentMovementWatcher (&componentToWatch),
+        component (componentToWatch),
+        onScaleChanged (std::move (scaleChangedCallback))
+    {
+        topLevelListener.owner = this;
+
+        updatePeer();
+        updateTopLevelComponent();
+
+        currentScale = getEffectiveScale (component);
+    }
+
+    ~DisplayScaleWatcher() override
+    {
+        if (peer != nullptr && juce::ComponentPeer::isValidPeer (peer))
+            peer->removeScaleFactorListener (this);
+
+        if (topLevelComponent != nullptr)
+            topLevelComponent->removeComponentListener (&topLevelListener);
+    }
+
+    /** Returns the effective scale the watched component is currently displayed at */
+    float getScale() const { return currentScale; }
+
+    /**
+     * Returns the effective scale of a component, computed from the display the centre of the component is
+     * located on and the transforms applied to the component and its parents
+     */
+    static float getEffectiveScale (juce::Component& c)
+    {
+        auto displayScale = 1.0;
+
+        if (auto* display = juce::Desktop::getInstance().getDisplays().getDisplayForPoint (c.getScreenBounds().getCentre()))
+            displayScale = display->scale;
+
+        return static_cast<float> (displayScale) * juce::Component::getApproximateScaleFactorForComponent (&c);
+    }
+
+private:
+
+    // Moving the top level window does not change the position of our component relative to its peer, so the
+    // ComponentMovementWatcher won't tell us about it. This listener is attached to the top level component instead
+    struct TopLevelListener : public juce::ComponentListener
+    {
+        void componentMovedOrResized (juce::Component&, bool wasMoved, bool) override
+        {
+            if (wasMoved)
+                owner->updateScale();
+        }
+
+        DisplayScaleWatcher* owner = nullptr;
+    };
+
+    juce::Component& component;
+    std::function<void()> onScaleChanged;
+
+    juce::ComponentPeer* peer = nullptr;
+    juce::Component::SafePointer<juce::Component> topLevelComponent;
+    TopLevelListener topLevelListener;
+
+    float currentScale = 1.0f;
+
+    void updateScale()
+    {
+        auto newScale = getEffectiveScale (component);
+
+        if (newScale == currentScale)
+            return;
+
+        currentScale = newScale;
+
+        if (onScaleChanged != nullptr)
+            onScaleChanged();
+    }
+
+    void updatePeer()
+    {
+        auto* newPeer = component.getPeer();
+
+        if (newPeer == peer)
+            return;
+
+        // The old peer might already have been deleted at this point
+        if (peer != nullptr && juce::ComponentPeer::isValidPeer (peer))
+            peer->removeScaleFactorListener (this);
+
+        peer = newPeer;
+
+        if (peer != nullptr)
+            peer->addScaleFactorListener (this);
+    }
+
+    void updateTopLevelComponent()
+    {
+        auto* newTopLevelComponent = component.getTopLevelComponent();
+
+        if (newTopLevelComponent == topLevelComponent.getComponent())
+            return;
+
+        if (topLevelComponent != nullptr)
+            topLevelComponent->removeComponentListener (&topLevelListener);
+
+        topLevelComponent = newTopLevelComponent;
+        topLevelComponent->addComponentListener (&topLevelListener);
+    }
+
+    using juce::ComponentMovementWatcher::componentMovedOrResized;
+    using juce::ComponentMovementWatcher::componentVisibilityChanged;
+
+    void componentMovedOrResized (bool, bool) override
+    {
+        updateScale();
+    }
+
+    void componentPeerChanged() override
+    {
+        updatePeer();
+        updateTopLevelComponent();
+        updateScale();
+    }
+
+    void componentVisibilityChanged() override
+    {
+        updateScale();
+    }
+
+    void componentParentHierarchyChanged (juce::Component& c) override
+    {
+        juce::ComponentMovementWatcher::componentParentHierarchyChanged (c);
+
+        updateTopLevelComponent();
+        updateScale();
+    }
+
+    void nativeScaleFactorChanged (double) override
+    {
+        updateScale();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DisplayScaleWatcher)
+};
+
+}
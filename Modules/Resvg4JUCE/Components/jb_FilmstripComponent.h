@@ -0,0 +1,111 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * A component that displays a single frame of a filmstrip, i.e. an image of equally sized frames stacked vertically
+ * as generated by Resvg::FilmstripGenerator. Switching frames only draws another part of the filmstrip image, so
+ * animating knobs or meters does not need any rendering. For sharp results, generate the filmstrip with a frame size
+ * matching the component size multiplied by the display scale.
+ */
+class FilmstripComponent : public juce::Component
+{
+public:
+
+    /** Creates a component displaying the first frame of the filmstrip passed */
+    FilmstripComponent (const juce::Image& filmstripImage, int numFramesInFilmstrip)
+    {
+        setFilmstrip (filmstripImage, numFramesInFilmstrip);
+        setInterceptsMouseClicks (false, false);
+    }
+
+    /** Replaces the filmstrip displayed. The current frame index is kept if it is valid for the new filmstrip */
+    void setFilmstrip (const juce::Image& filmstripImage, int numFramesInFilmstrip)
+    {
+        jassert (numFramesInFilmstrip > 0);
+        jassert (filmstripImage.getHeight() % numFramesInFilmstrip == 0);
+
+        filmstrip = filmstripImage;
+        numFrames = numFramesInFilmstrip;
+        currentFrame = juce::jlimit (0, numFrames - 1, currentFrame);
+
+        repaint();
+    }
+
+    /** Returns the number of frames in the filmstrip */
+    int getNumFrames() const
+    {
+        return numFrames;
+    }
+
+    /** Selects the frame to display */
+    void setFrame (int frameIndex)
+    {
+        frameIndex = juce::jlimit (0, numFrames - 1, frameIndex);
+
+        if (frameIndex == currentFrame)
+            return;
+
+        currentFrame = frameIndex;
+        repaint();
+    }
+
+    /** Selects the frame to display from a proportion between 0 and 1, e.g. the normalised value of a knob */
+    void setFrameFromProportion (double proportion)
+    {
+        setFrame (juce::roundToInt (juce::jlimit (0.0, 1.0, proportion) * (numFrames - 1)));
+    }
+
+    /** Returns the index of the frame displayed */
+    int getFrame() const
+    {
+        return currentFrame;
+    }
+
+    /** Sets how the frame is placed on the components surface */
+    void setImagePlacement (juce::RectanglePlacement placement)
+    {
+        imagePlacement = placement;
+        repaint();
+    }
+
+    /** Returns how the frame is placed on the components surface */
+    juce::RectanglePlacement getImagePlacement()
+    {
+        return imagePlacement;
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        const auto frameWidth = filmstrip.getWidth();
+        const auto frameHeight = filmstrip.getHeight() / numFrames;
+
+        auto dstArea = imagePlacement.appliedTo (juce::Rectangle<float> (static_cast<float> (frameWidth), static_cast<float> (frameHeight)),
+                                                 getLocalBounds().toFloat()).toNearestInt();
+
+        g.drawImage (filmstrip,
+                     dstArea.getX(), dstArea.getY(), dstArea.getWidth(), dstArea.getHeight(),
+                     0, currentFrame * frameHeight, frameWidth, frameHeight);
+    }
+
+private:
+
+    juce::Image filmstrip;
+
+    int numFrames = 1;
+    int currentFrame = 0;
+
+    juce::RectanglePlacement imagePlacement = juce::RectanglePlacement::centred;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilmstripComponent)
+};
+
+}
@@ -0,0 +1,83 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * Keeps one rendered image per display scale for the last few scales used. This way, moving a window back and forth
+ * between displays with different scale factors does not require rendering the SVG again each time. Resizing only
+ * replaces the image stored for the current scale, so the number of images held never exceeds the number of scales.
+ */
+class RasterCache
+{
+public:
+
+    /** Creates a cache that keeps the images for at most maxNumScales different scales */
+    RasterCache (size_t maxNumScales = 3) : maxNumEntries (maxNumScales)
+    {
+        jassert (maxNumEntries > 0);
+    }
+
+    /**
+     * Returns the image stored for the scale if it has been rendered for exactly the bounds passed. Returns an invalid
+     * image otherwise.
+     */
+    juce::Image get (float scale, juce::Rectangle<float> bounds)
+    {
+        auto entry = findEntry (scale);
+
+        if (entry == entries.end() || entry->bounds != bounds)
+            return {};
+
+        // Move the entry to the front to mark it as most recently used
+        std::rotate (entries.begin(), entry, entry + 1);
+
+        return entries.front().image;
+    }
+
+    /** Stores the image rendered for the bounds at the given scale, replacing any image previously stored for it */
+    void set (float scale, juce::Rectangle<float> bounds, const juce::Image& image)
+    {
+        auto entry = findEntry (scale);
+
+        if (entry != entries.end())
+            entries.erase (entry);
+
+        entries.insert (entries.begin(), { scale, bounds, image });
+
+        if (entries.size() > maxNumEntries)
+            entries.pop_back();
+    }
+
+    /** Releases all images held by this cache */
+    void clear()
+    {
+        entries.clear();
+    }
+
+private:
+
+    struct Entry
+    {
+        float scale;
+        juce::Rectangle<float> bounds;
+        juce::Image image;
+    };
+
+    std::vector<Entry> entries;
+    size_t maxNumEntries;
+
+    std::vector<Entry>::iterator findEntry (float scale)
+    {
+        return std::find_if (entries.begin(), entries.end(), [scale] (const Entry& e) { return e.scale == scale; });
+    }
+};
+
+}
@@ -0,0 +1,98 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * Base class for everything that holds images rendered from SVGs. Registered instances can be found by
+ * releaseAllRasters, which frees the memory held by them, e.g. when your application receives a memory warning.
+ * Owners are expected to render their images again the next time they are needed.
+ *
+ * Owners might be created and destroyed on any thread, so the most derived class registers itself at the end of its
+ * constructor and unregisters at the start of its destructor. Otherwise releaseAllRasters could call releaseRasters
+ * on an object that is only partly constructed or destroyed.
+ */
+class RasterOwner
+{
+public:
+
+    RasterOwner() = default;
+
+    virtual ~RasterOwner()
+    {
+        // The most derived class has to unregister in its destructor already
+        jassert (! getRegistry().contains (this));
+        unregisterOwner();
+    }
+
+    /** Releases all rendered images held by this owner. Will be called on the message thread */
+    virtual void releaseRasters() = 0;
+
+    /**
+     * Releases the rendered images held by all owners and frees the pixel buffers retained for reuse by the
+     * Resvg::PixelBufferPool. Must be called on the message thread
+     */
+    static void releaseAllRasters()
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        // Keeps the pool alive while the images are released, so that their buffers can be freed afterwards
+        juce::SharedResourcePointer<Resvg::PixelBufferPool> pixelBufferPool;
+
+        {
+            auto& registry = getRegistry();
+            const juce::ScopedLock sl (registry.getLock());
+
+            for (auto* owner : registry)
+                owner->releaseRasters();
+        }
+
+        pixelBufferPool->trim();
+    }
+
+protected:
+
+    /** Makes this owner known to releaseAllRasters. Call it at the end of the constructor of the most derived class */
+    void registerOwner()
+    {
+        getRegistry().addIfNotAlreadyThere (this);
+    }
+
+    /**
+     * Removes this owner from the registry. Call it at the start of the destructor of the most derived class. Blocks
+     * while releaseAllRasters is running on another thread
+     */
+    void unregisterOwner()
+    {
+        getRegistry().removeFirstMatchingValue (this);
+    }
+
+    /**
+     * Releases the rendered images held by this owner and frees their pixel buffers instead of returning them to the
+     * Resvg::PixelBufferPool for reuse. Buffers retained for other owners are not affected.
+     */
+    void releaseRastersAndBuffers()
+    {
+        const Resvg::PixelBufferPool::ScopedEviction eviction;
+        releaseRasters();
+    }
+
+private:
+
+    static juce::Array<RasterOwner*, juce::CriticalSection>& getRegistry()
+    {
+        static juce::Array<RasterOwner*, juce::CriticalSection> registry;
+        return registry;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (RasterOwner)
+};
+
+}
@@ -11,12 +11,15 @@ namespace jb
 {
 
 /** A simple two state button using two SVGs for on and off state */
-class SVGButton : public juce::Button
+class SVGButton : public juce::Button,
+                  public ComponentRasterOwner,
+                  public PrewarmableSVG
 {
 public:
 
     SVGButton (const char* offData, int offSize, const char* onData, int onSize, const juce::String& buttonName = "")
-      : juce::Button (buttonName)
+      : juce::Button (buttonName),
+        ComponentRasterOwner (*this)
     {
         auto successLoadingOff = offSVG.loadFromBinaryData (offData, offSize);
         auto successLoadingOn  = onSVG.loadFromBinaryData (onData, onSize);
@@ -25,22 +28,49 @@ public:
         jassert (successLoadingOn);
 
         juce::ignoreUnused (successLoadingOff, successLoadingOn);
+
+        registerOwner();
     }
 
-    void resized() override
+    ~SVGButton() override
+    {
+        unregisterOwner();
+    }
+
+    void releaseRasters() override
     {
-        auto displayScale = juce::Desktop::getInstance().getDisplays().getDisplayForPoint (getBounds().getCentre())->scale;
-        auto componentScale = getApproximateScaleFactorForComponent (this);
+        offImage = {};
+        onImage = {};
+        cachedImageBounds = {};
+
+        offCache.clear();
+        onCache.clear();
+    }
 
-        auto newImageBounds = getLocalBounds().toFloat() * displayScale * componentScale;
+    void addPendingRenders (std::vector<PendingRender>& renders, float scale) override
+    {
+        auto imageBounds = getLocalBounds().toFloat() * scale;
 
-        if (newImageBounds == cachedImageBounds)
+        if (imageBounds.isEmpty() || imageBounds == cachedImageBounds)
             return;
 
-        offImage = offSVG.render (newImageBounds, backgroundColour);
-        onImage  = onSVG.render  (newImageBounds, backgroundColour);
+        if (! offCache.get (scale, imageBounds).isValid())
+            renders.push_back ({ &offSVG, imageBounds, backgroundColour, [this, scale, imageBounds] (const juce::Image& image)
+            {
+                offCache.set (scale, imageBounds, image);
+            }});
+
+        if (! onCache.get (scale, imageBounds).isValid())
+            renders.push_back ({ &onSVG, imageBounds, backgroundColour, [this, scale, imageBounds] (const juce::Image& image)
+            {
+                onCache.set (scale, imageBounds, image);
+            }});
+    }
 
-        cachedImageBounds = newImageBounds;
+    void resized() override
+    {
+        if (updateCachedImages())
+            repaint();
     }
 
 private:
@@ -54,8 +84,47 @@ private:
 
     juce::Rectangle<float> cachedImageBounds;
 
+    RasterCache offCache;
+    RasterCache onCache;
+    DisplayScaleWatcher scaleWatcher { *this, [this] { if (updateCachedImages()) repaint(); } };
+
+    // Returns true if the images to display have changed. Rendering is deferred to the next paint call while the
+    // button is not showing, so that SVGPrewarmer can collect it, unless renderEvenIfHidden is set
+    bool updateCachedImages (bool renderEvenIfHidden = false)
+    {
+        auto scale = scaleWatcher.getScale();
+        auto newImageBounds = getLocalBounds().toFloat() * scale;
+
+        if (newImageBounds.isEmpty() || newImageBounds == cachedImageBounds)
+            return false;
+
+        if (! shouldRender (renderEvenIfHidden))
+            return false;
+
+        offImage = offCache.get (scale, newImageBounds);
+        onImage  = onCache.get  (scale, newImageBounds);
+
+        if (! offImage.isValid())
+        {
+            offImage = offSVG.render (newImageBounds, backgroundColour);
+            offCache.set (scale, newImageBounds, offImage);
+        }
+
+        if (! onImage.isValid())
+        {
+            onImage = onSVG.render (newImageBounds, backgroundColour);
+            onCache.set (scale, newImageBounds, onImage);
+        }
+
+        cachedImageBounds = newImageBounds;
+        return true;
+    }
+
     void paintButton (juce::Graphics& g, bool, bool) override
     {
+        // Renders the images in case they were released or skipped while the button was hidden
+        updateCachedImages (true);
+
         auto& imageToDraw = getToggleState() ? onImage : offImage;
 
         g.drawImage (imageToDraw, getLocalBounds().toFloat(), juce::RectanglePlacement::centred);
@@ -0,0 +1,86 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * A rough estimation of how complex an SVG document is to draw. It is used to decide whether a document is simple
+ * enough to be drawn as vectors by juce::Drawable on each paint call instead of rendering and holding a raster image
+ * through resvg. Documents using any feature the juce SVG parser doesn't support well or that requires compositing
+ * are never considered simple.
+ */
+struct SVGComplexity
+{
+    /** The number of basic shapes, i.e. path, rect, circle, ellipse, line, polyline and polygon elements */
+    int numShapes = 0;
+
+    /** True if the document uses gradients, patterns, filters, masks, clip paths, text, images or group opacity */
+    bool usesAdvancedFeatures = false;
+
+    /**
+     * The default maximum number of shapes for a document to be considered simple. There are no benchmark results
+     * shipping with the module yet, so it is 0 unless JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS is set. Run the
+     * BackendBenchmark example on your target machines, it writes its results to Examples/BackendBenchmark/Results
+     * and suggests a value for JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS.
+     */
+    static constexpr int defaultMaxNumShapes = JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS;
+
+    /** Returns true if the document can be drawn as vectors without a noticeable cost or quality loss */
+    bool isSimple (int maxNumShapes = defaultMaxNumShapes) const
+    {
+        return ! usesAdvancedFeatures && numShapes <= maxNumShapes;
+    }
+
+    /** Analyses the svg element passed and all its children */
+    static SVGComplexity analyse (const juce::XmlElement& svg)
+    {
+        SVGComplexity complexity;
+        complexity.analyseElement (svg);
+
+        return complexity;
+    }
+
+private:
+
+    void analyseElement (const juce::XmlElement& element)
+    {
+        static const juce::StringArray shapeTags { "path", "rect", "circle", "ellipse", "line", "polyline", "polygon" };
+
+        static const juce::StringArray advancedTags { "linearGradient", "radialGradient", "pattern", "filter", "mask",
+                                                      "clipPath", "text", "image", "use", "style", "marker",
+                                                      "foreignObject", "switch" };
+
+        static const juce::StringArray advancedAttributes { "filter", "mask", "clip-path", "opacity" };
+
+        auto tag = element.getTagNameWithoutNamespace();
+
+        if (shapeTags.contains (tag))
+            ++numShapes;
+
+        if (advancedTags.contains (tag))
+            usesAdvancedFeatures = true;
+
+        for (auto& attribute : advancedAttributes)
+            if (element.hasAttribute (attribute))
+                usesAdvancedFeatures = true;
+
+        // The same properties can also be set through inline style declarations
+        auto declarations = juce::StringArray::fromTokens (element.getStringAttribute ("style"), ";", "");
+
+        for (auto& declaration : declarations)
+            if (advancedAttributes.contains (declaration.upToFirstOccurrenceOf (":", false, false).trim()))
+                usesAdvancedFeatures = true;
+
+        for (auto* child = element.getFirstChildElement(); child != nullptr; child = child->getNextElement())
+            analyseElement (*child);
+    }
+};
+
+}
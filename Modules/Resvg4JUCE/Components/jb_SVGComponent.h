@@ -12,40 +12,96 @@ namespace jb
 
 /**
  * A component that owns an Resvg::RenderTree. On each resize, it renders an Image according to the Components size
- * and displays it according to the placement set through setImagePlacement (default is centred)
+ * and displays it according to the placement set through setImagePlacement (default is centred). The image is
+ * re-rendered automatically when the component is moved to a display with a different scale factor, the images for
+ * the last few scales are kept so that moving back does not need to render again.
+ *
+ * When created with Backend::automatic, the complexity of the document is analysed when loading it and simple
+ * documents are drawn as vectors through a juce::Drawable instead, as holding a raster for them costs more than
+ * drawing their few paths on each paint call. Which documents count as simple depends on the
+ * JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS module option, which has to be set from benchmark results, see SVGComplexity.
  */
-class SVGComponent : public juce::Component
+class SVGComponent : public juce::Component,
+                     public ComponentRasterOwner,
+                     public PrewarmableSVG
 {
 public:
 
+    /** Selects how the SVG is drawn */
+    enum class Backend
+    {
+        /** Always renders the SVG to an image through resvg */
+        raster,
+
+        /** Draws simple SVGs as vectors through a juce::Drawable and renders complex ones through resvg */
+        automatic,
+    };
+
     /**
-     * Creates an SVGComponent from an svg file. You have to make sure that this is a valid svg, otherwise
-     * behaviour is undefined
+     * Creates an SVGComponent from an svg file. Use isValid to check whether the file could be parsed, a component
+     * holding an invalid svg doesn't draw anything
      */
-    SVGComponent (const juce::File& svgFile)
+    SVGComponent (const juce::File& svgFile, Backend backend = Backend::raster)
+      : ComponentRasterOwner (*this),
+        sourceFile (svgFile)
     {
-        auto successLoading = svg.loadFromFile (svgFile);
+        if (backend == Backend::automatic)
+            if (auto xml = juce::parseXML (svgFile))
+                createDrawableIfSimple (*xml);
 
-        jassert (successLoading);
-        juce::ignoreUnused (successLoading);
+        valid = isDrawnAsVectors() || svg->loadFromFile (svgFile);
+
+        registerOwner();
     }
 
     /**
-     * Creates an SVGComponent from an binary data. You have to make sure that this is a valid svg, otherwise
-     * behaviour is undefined
+     * Creates an SVGComponent from an binary data. Use isValid to check whether the data could be parsed, a component
+     * holding an invalid svg doesn't draw anything. The data is not copied. If you enable progressive rendering, it
+     * has to stay valid until setProgressiveRendering has been called, which is always the case for BinaryData.
      */
-    SVGComponent (const char* svgData, int svgSize)
+    SVGComponent (const char* svgData, int svgSize, Backend backend = Backend::raster)
+      : ComponentRasterOwner (*this),
+        sourceData (svgData),
+        sourceSize (svgSize)
     {
-        auto successLoading = svg.loadFromBinaryData (svgData, svgSize);
+        if (backend == Backend::automatic)
+            if (auto xml = juce::parseXML (juce::String::fromUTF8 (svgData, svgSize)))
+                createDrawableIfSimple (*xml);
+
+        valid = isDrawnAsVectors() || svg->loadFromBinaryData (svgData, svgSize);
 
-        jassert (successLoading);
-        juce::ignoreUnused (successLoading);
+        registerOwner();
     }
 
     /** Creates an SVGComponent from a pre-generated svgRenderTree */
-    SVGComponent (Resvg::RenderTree&& svgRenderTree) : svg (std::move (svgRenderTree))
+    SVGComponent (Resvg::RenderTree&& svgRenderTree)
+      : ComponentRasterOwner (*this),
+        svg (std::make_shared<Resvg::RenderTree> (std::move (svgRenderTree)))
+    {
+        valid = svg->isValid();
+        jassert (valid);
+
+        registerOwner();
+    }
+
+    ~SVGComponent() override
     {
-        jassert (svg.isValid());
+        unregisterOwner();
+
+        // Makes pending background renders return without rendering
+        *latestRenderId = -1;
+    }
+
+    /** Returns true if the SVG passed to the constructor could be parsed */
+    bool isValid() const
+    {
+        return valid;
+    }
+
+    /** Returns true if the SVG is drawn as vectors instead of being rendered through resvg */
+    bool isDrawnAsVectors() const
+    {
+        return drawable != nullptr;
     }
 
     /** Sets how the image generated from the SVG is placed on the components surface */
@@ -60,34 +116,231 @@ public:
         return imagePlacement;
     }
 
-    void resized() override
+    /**
+     * Enables progressive rendering. Whenever a new image has to be rendered, a preview with a reduced resolution is
+     * rendered and displayed right away, while the full resolution image is rendered on a background thread and
+     * swapped in as soon as it is ready. The preview resolution is given relative to the full resolution in each
+     * dimension. This gives immediate visual feedback for heavy SVGs that take long to render.
+     *
+     * Previews are rendered from a second tree parsed with the optimizeSpeed rendering modes when progressive
+     * rendering is enabled for the first time, so that they never wait for a background render of the main tree.
+     * Components created from a RenderTree have no source to parse that tree from, they keep displaying their
+     * previous image until the full resolution image is ready instead.
+     */
+    void setProgressiveRendering (bool shouldRenderProgressively, float previewResolution = 0.25f)
     {
-        auto displayScale = juce::Desktop::getInstance().getDisplays().getDisplayForPoint (getBounds().getCentre())->scale;
-        auto componentScale = getApproximateScaleFactorForComponent (this);
+        jassert (previewResolution > 0.0f && previewResolution <= 1.0f);
 
-        auto newImageBounds = getLocalBounds().toFloat() * displayScale * componentScale;
+        progressiveRendering = shouldRenderProgressively;
+        previewScale = previewResolution;
 
-        if (newImageBounds == cachedImageBounds)
+        if (! progressiveRendering)
             return;
 
-        cachedImage = svg.render (newImageBounds);
-        cachedImageBounds = newImageBounds;
+        if (renderPool == nullptr)
+            renderPool = std::make_unique<juce::SharedResourcePointer<Resvg::RenderThreadPool>>();
+
+        if (previewSvg != nullptr || ! valid || isDrawnAsVectors())
+            return;
+
+        Resvg::Options previewOptions;
+        previewOptions.shapeRendering = Resvg::ShapeRenderingMode::optimizeSpeed;
+        previewOptions.textRendering  = Resvg::TextRenderingMode::optimizeSpeed;
+        previewOptions.imageRendering = Resvg::ImageRenderingMode::optimizeSpeed;
+
+        previewSvg = std::make_unique<Resvg::RenderTree> (previewOptions);
+
+        auto successLoading = false;
+
+        if (sourceData != nullptr)
+            successLoading = previewSvg->loadFromBinaryData (sourceData, sourceSize);
+        else if (sourceFile.existsAsFile())
+            successLoading = previewSvg->loadFromFile (sourceFile);
+
+        if (! successLoading)
+            previewSvg.reset();
+
+        // The source is not needed anymore once the preview tree exists
+        sourceData = nullptr;
+        sourceFile = juce::File();
+    }
+
+    /** Returns true if progressive rendering has been enabled */
+    bool isRenderingProgressively() const
+    {
+        return progressiveRendering;
+    }
+
+    void releaseRasters() override
+    {
+        // Makes pending background renders return without rendering
+        ++(*latestRenderId);
+
+        cachedImage = {};
+        cachedImageBounds = {};
+        rasterCache.clear();
+    }
+
+    void addPendingRenders (std::vector<PendingRender>& renders, float scale) override
+    {
+        auto imageBounds = getLocalBounds().toFloat() * scale;
+
+        if (drawable != nullptr || ! valid || imageBounds.isEmpty() || imageBounds == cachedImageBounds)
+            return;
+
+        if (rasterCache.get (scale, imageBounds).isValid())
+            return;
+
+        renders.push_back ({ svg.get(), imageBounds, juce::Colours::transparentBlack, [this, scale, imageBounds] (const juce::Image& image)
+        {
+            rasterCache.set (scale, imageBounds, image);
+        }});
+    }
+
+    void resized() override
+    {
+        if (updateCachedImage())
+            repaint();
     }
 
     void paint (juce::Graphics& g) override
     {
+        if (drawable != nullptr)
+        {
+            drawable->drawWithin (g, getLocalBounds().toFloat(), imagePlacement, 1.0f);
+            return;
+        }
+
+        // Renders the image in case it was released or skipped while the component was hidden
+        updateCachedImage (true);
+
         g.drawImage (cachedImage, getLocalBounds().toFloat(), imagePlacement);
     }
 
 private:
-    SVGComponent() {}
+    SVGComponent() : ComponentRasterOwner (*this)
+    {
+        registerOwner();
+    }
+
+    std::shared_ptr<Resvg::RenderTree> svg = std::make_shared<Resvg::RenderTree>();
+    std::unique_ptr<Resvg::RenderTree> previewSvg;
+    std::unique_ptr<juce::Drawable> drawable;
+
+    // The source the svg was loaded from, used to parse the preview tree when progressive rendering is enabled
+    juce::File sourceFile;
+    const char* sourceData = nullptr;
+    int sourceSize = 0;
 
-    Resvg::RenderTree svg;
+    bool valid = false;
 
     juce::Image cachedImage;
     juce::Rectangle<float> cachedImageBounds;
 
+    RasterCache rasterCache;
+    DisplayScaleWatcher scaleWatcher { *this, [this] { if (updateCachedImage()) repaint(); } };
+
     juce::RectanglePlacement imagePlacement = juce::RectanglePlacement::centred;
+
+    bool progressiveRendering = false;
+    float previewScale = 0.25f;
+
+    // Shared with the background render jobs so that outdated jobs can be skipped
+    std::shared_ptr<std::atomic<int>> latestRenderId = std::make_shared<std::atomic<int>> (0);
+    std::unique_ptr<juce::SharedResourcePointer<Resvg::RenderThreadPool>> renderPool;
+
+    void createDrawableIfSimple (const juce::XmlElement& svgElement)
+    {
+        if (SVGComplexity::analyse (svgElement).isSimple())
+            drawable = juce::Drawable::createFromSVG (svgElement);
+    }
+
+    // Returns true if the image to display has changed. Rendering is deferred to the next paint call while the
+    // component is not showing, so that SVGPrewarmer can collect it, unless renderEvenIfHidden is set
+    bool updateCachedImage (bool renderEvenIfHidden = false)
+    {
+        if (drawable != nullptr || ! valid)
+            return false;
+
+        auto scale = scaleWatcher.getScale();
+        auto newImageBounds = getLocalBounds().toFloat() * scale;
+
+        if (newImageBounds.isEmpty() || newImageBounds == cachedImageBounds)
+            return false;
+
+        if (! shouldRender (renderEvenIfHidden))
+            return false;
+
+        cachedImageBounds = newImageBounds;
+
+        auto image = rasterCache.get (scale, newImageBounds);
+
+        if (image.isValid())
+        {
+            // A full resolution image from the cache supersedes any render that might still be in progress
+            cachedImage = image;
+            ++(*latestRenderId);
+
+            return true;
+        }
+
+        auto previewBounds = newImageBounds * previewScale;
+
+        if (progressiveRendering && previewBounds.getWidth() >= 1.0f && previewBounds.getHeight() >= 1.0f)
+        {
+            // The main tree might be locked by a background render, so the preview must not be rendered from it.
+            // Without a preview tree, the previous image, if any, is displayed until the new one is ready
+            if (previewSvg != nullptr)
+                cachedImage = previewSvg->render (previewBounds);
+
+            renderInBackground (scale, newImageBounds);
+        }
+        else
+        {
+            cachedImage = svg->render (newImageBounds);
+            rasterCache.set (scale, newImageBounds, cachedImage);
+        }
+
+        return true;
+    }
+
+    void renderInBackground (float scale, juce::Rectangle<float> imageBounds)
+    {
+        auto renderId = ++(*latestRenderId);
+
+        auto tree = svg;
+        auto latestId = latestRenderId;
+        juce::Component::SafePointer<SVGComponent> safeThis (this);
+
+        (*renderPool)->addJob ([tree, latestId, renderId, scale, imageBounds, safeThis]
+        {
+            if (*latestId != renderId)
+                return;
+
+            auto image = tree->render (imageBounds);
+
+            juce::MessageManager::callAsync ([safeThis, renderId, scale, imageBounds, image]
+            {
+                if (safeThis != nullptr)
+                    safeThis->backgroundRenderFinished (renderId, scale, imageBounds, image);
+            });
+        });
+    }
+
+    void backgroundRenderFinished (int renderId, float scale, juce::Rectangle<float> imageBounds, const juce::Image& image)
+    {
+        // Renders that have been superseded must neither be displayed nor overwrite the cache
+        if (renderId != *latestRenderId)
+            return;
+
+        rasterCache.set (scale, imageBounds, image);
+
+        if (imageBounds != cachedImageBounds)
+            return;
+
+        cachedImage = image;
+        repaint();
+    }
 };
 
 }
@@ -0,0 +1,158 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * A juce::Drawable that draws an SVG through a shared Resvg::RenderTree. It can be used wherever juce expects a
+ * Drawable, e.g. in LookAndFeel overrides, DrawableButton or Drawable::drawWithin, as a drop-in replacement for
+ * juce::Drawable::createFromSVG. On each draw call, the SVG is rendered at the effective resolution of the device it
+ * is drawn to. The images are cached per scale, which is rounded up to steps of a quarter octave, so drawing at the
+ * same scale again only needs to draw the cached image.
+ */
+class SVGDrawable : public juce::Drawable,
+                    public RasterOwner
+{
+public:
+
+    /** Creates a drawable from a render tree which can be shared with other drawables or components */
+    SVGDrawable (std::shared_ptr<Resvg::RenderTree> sharedTree) : tree (std::move (sharedTree))
+    {
+        jassert (tree != nullptr && tree->isValid());
+
+        bounds = tree->getSize().toFloat();
+        setBoundsToEnclose (bounds);
+
+        registerOwner();
+    }
+
+    ~SVGDrawable() override
+    {
+        unregisterOwner();
+    }
+
+    /** Creates a drawable from an svg element. Returns nullptr if the SVG could not be parsed */
+    static std::unique_ptr<SVGDrawable> createFromSVG (const juce::XmlElement& svgDocument)
+    {
+        auto svgText = svgDocument.toString();
+        return createFromSVGData (svgText.toRawUTF8(), svgText.getNumBytesAsUTF8());
+    }
+
+    /** Creates a drawable from an svg file. Returns nullptr if the SVG could not be parsed */
+    static std::unique_ptr<SVGDrawable> createFromSVGFile (const juce::File& svgFile)
+    {
+        auto newTree = std::make_shared<Resvg::RenderTree>();
+
+        if (! newTree->loadFromFile (svgFile))
+            return nullptr;
+
+        return std::make_unique<SVGDrawable> (std::move (newTree));
+    }
+
+    /** Creates a drawable from binary svg data. Returns nullptr if the SVG could not be parsed */
+    static std::unique_ptr<SVGDrawable> createFromSVGData (const void* svgData, size_t svgSize)
+    {
+        auto newTree = std::make_shared<Resvg::RenderTree>();
+
+        if (! newTree->loadFromBinaryData (static_cast<const char*> (svgData), static_cast<int> (svgSize)))
+            return nullptr;
+
+        return std::make_unique<SVGDrawable> (std::move (newTree));
+    }
+
+    /** Returns the render tree drawn by this drawable */
+    std::shared_ptr<Resvg::RenderTree> getRenderTree() const
+    {
+        return tree;
+    }
+
+    std::unique_ptr<juce::Drawable> createCopy() const override
+    {
+        // The copy shares the render tree but keeps its own cache
+        return std::unique_ptr<juce::Drawable> (new SVGDrawable (*this));
+    }
+
+    juce::Rectangle<float> getDrawableBounds() const override
+    {
+        return bounds;
+    }
+
+    juce::Path getOutlineAsPath() const override
+    {
+        juce::Path outline;
+        outline.addRectangle (bounds);
+
+        return outline;
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        auto physicalScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        if (physicalScale <= 0.0f)
+            return;
+
+        // Scales are rounded up to quarter octave steps, so the image is never more than 19% bigger than needed, no
+        // matter if a large document is drawn as a tiny icon or a small one is zoomed in. Rounding up avoids rendering
+        // at a lower resolution than the device resolution. Scales computed from transforms are often slightly above
+        // the exact value, e.g. 2.0000002, which must not be rounded up to the next step
+        auto scale = std::exp2 (std::ceil (std::log2 (physicalScale) * 4.0f - 1.0e-3f) / 4.0f);
+        auto imageBounds = bounds.withZeroOrigin() * scale;
+
+        if (imageBounds.getWidth() < 1.0f || imageBounds.getHeight() < 1.0f)
+            return;
+
+        juce::Image image;
+
+        {
+            // Drawables might be drawn on other threads while releaseAllRasters runs on the message thread
+            const juce::ScopedLock sl (cacheLock);
+
+            image = rasterCache.get (scale, imageBounds);
+
+            if (! image.isValid())
+            {
+                image = tree->render (imageBounds);
+                rasterCache.set (scale, imageBounds, image);
+            }
+        }
+
+        // The rendered image keeps the exact aspect ratio of the SVG, while the bounds are based on its integer size
+        g.drawImage (image, bounds, juce::RectanglePlacement::centred);
+    }
+
+    void releaseRasters() override
+    {
+        const juce::ScopedLock sl (cacheLock);
+        rasterCache.clear();
+    }
+
+private:
+
+    SVGDrawable (const SVGDrawable& other)
+      : juce::Drawable (other),
+        tree (other.tree),
+        bounds (other.bounds)
+    {
+        setBoundsToEnclose (bounds);
+
+        registerOwner();
+    }
+
+    std::shared_ptr<Resvg::RenderTree> tree;
+    juce::Rectangle<float> bounds;
+
+    RasterCache rasterCache;
+    juce::CriticalSection cacheLock;
+
+    JUCE_LEAK_DETECTOR (SVGDrawable)
+};
+
+}
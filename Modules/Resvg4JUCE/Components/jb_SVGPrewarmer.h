@@ -0,0 +1,136 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/** Base class for components that render SVGs and allow that rendering to be done ahead of time by SVGPrewarmer */
+class PrewarmableSVG
+{
+public:
+
+    /** A render a component needs before it can be painted */
+    struct PendingRender
+    {
+        /** The tree to render */
+        Resvg::RenderTree* tree;
+
+        /** The bounds to pass to RenderTree::render */
+        juce::Rectangle<float> imageBounds;
+
+        /** The background to pass to RenderTree::render */
+        juce::Colour backgroundColour;
+
+        /** Called on the message thread with the rendered image */
+        std::function<void (const juce::Image&)> install;
+    };
+
+    virtual ~PrewarmableSVG() = default;
+
+    /** Adds the renders needed to paint the component at its current size and the given scale that are not done yet */
+    virtual void addPendingRenders (std::vector<PendingRender>& renders, float scale) = 0;
+};
+
+/**
+ * Renders the SVGs of all components in a hierarchy in parallel. SVG components don't render while they are not
+ * showing, so calling this on a component hierarchy that has been laid out but not shown yet, e.g. at the end of a
+ * plugin editor's constructor, collects all renders needed for the first paint call. These are distributed over the
+ * RenderThreadPool and the results are installed in the components before they are painted for the first time.
+ *
+ * Rasters are rendered for the scale of the display the components are shown on. Before a hierarchy has been added
+ * to the desktop, that display isn't known yet and the display at the components' current screen position is used,
+ * which is usually the primary display. If you know the scale of the display the window will open on, e.g. because
+ * you restore its position, pass it to prewarm, otherwise the first paint call on a display with another scale
+ * renders everything again.
+ */
+class SVGPrewarmer
+{
+public:
+
+    /**
+     * Renders all pending renders of the root component and its visible children. Blocks until all renders are done.
+     * If a display scale greater than zero is passed, it is used instead of the scale of the display the components
+     * are currently located on.
+     */
+    static void prewarm (juce::Component& rootComponent, double displayScale = 0.0)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        std::vector<PrewarmableSVG::PendingRender> renders;
+        collectPendingRenders (rootComponent, rootComponent, displayScale, renders);
+
+        const auto numRenders = static_cast<int> (renders.size());
+
+        if (numRenders == 0)
+            return;
+
+        std::vector<juce::Image> images (renders.size());
+        std::atomic<int> nextRender { 0 };
+
+        juce::SharedResourcePointer<Resvg::RenderThreadPool> pool;
+
+        pool->runInParallel (numRenders, [&] (int)
+        {
+            for (auto i = nextRender++; i < numRenders; i = nextRender++)
+            {
+                auto& render = renders[static_cast<size_t> (i)];
+                images[static_cast<size_t> (i)] = render.tree->render (render.imageBounds, render.backgroundColour);
+            }
+        });
+
+        for (size_t i = 0; i < renders.size(); ++i)
+            renders[i].install (images[i]);
+    }
+
+private:
+
+    // Returns true if the component is not completely clipped away by its parents up to the root component. Unlike
+    // VisibilityWatcher::isVisibleOnScreen, this doesn't depend on the hierarchy being shown already
+    static bool isVisibleWithin (juce::Component& rootComponent, juce::Component& component)
+    {
+        auto area = component.getLocalBounds();
+
+        for (auto* c = &component; c != &rootComponent && c->getParentComponent() != nullptr; c = c->getParentComponent())
+        {
+            auto* parent = c->getParentComponent();
+            area = parent->getLocalArea (c, area).getIntersection (parent->getLocalBounds());
+
+            if (area.isEmpty())
+                return false;
+        }
+
+        return ! area.isEmpty();
+    }
+
+    static void collectPendingRenders (juce::Component& rootComponent, juce::Component& component, double displayScale,
+                                       std::vector<PrewarmableSVG::PendingRender>& renders)
+    {
+        if (auto* prewarmable = dynamic_cast<PrewarmableSVG*> (&component))
+        {
+            // Components that must not hold rasters while they are clipped away, e.g. scrolled out of a viewport, are
+            // rendered when they become visible instead
+            auto* rasterOwner = dynamic_cast<ComponentRasterOwner*> (&component);
+
+            if (rasterOwner == nullptr || ! rasterOwner->releasesRastersWhenHidden() || isVisibleWithin (rootComponent, component))
+            {
+                auto scale = displayScale > 0.0 ? static_cast<float> (displayScale) * juce::Component::getApproximateScaleFactorForComponent (&component)
+                                                : DisplayScaleWatcher::getEffectiveScale (component);
+
+                prewarmable->addPendingRenders (renders, scale);
+            }
+        }
+
+        // Children that are hidden, e.g. the content of other tabs, will be rendered when they are shown
+        for (auto* child : component.getChildren())
+            if (child->isVisible())
+                collectPendingRenders (rootComponent, *child, displayScale, renders);
+    }
+};
+
+}
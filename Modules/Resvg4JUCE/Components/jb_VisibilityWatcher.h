@@ -0,0 +1,120 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+/**
+ * Watches whether a component is actually visible on screen, i.e. it is showing and not completely clipped away by
+ * its parents, e.g. because it has been scrolled out of a viewport or a parent panel has been collapsed to zero size.
+ * Invokes a callback whenever that changes.
+ */
+class VisibilityWatcher : private juce::ComponentMovementWatcher
+{
+public:
+
+    /** Starts watching the component. The callback is invoked on the message thread with the new visibility */
+    VisibilityWatcher (juce::Component& componentToWatch, std::function<void (bool)> visibilityChangedCallback)
+      : juce::ComponentMovementWatcher (&componentToWatch),
+        component (componentToWatch),
+        onVisibilityChanged (std::move (visibilityChangedCallback)),
+        wasVisible (isVisibleOnScreen (component))
+    {
+        parentListener.owner = this;
+        updateParents();
+    }
+
+    ~VisibilityWatcher() override
+    {
+        for (auto& parent : parents)
+            if (parent != nullptr)
+                parent->removeComponentListener (&parentListener);
+    }
+
+    /** Returns true if the component is showing and not completely clipped away by its parents */
+    static bool isVisibleOnScreen (juce::Component& c)
+    {
+        if (! c.isShowing())
+            return false;
+
+        juce::RectangleList<int> visibleArea;
+        c.getVisibleArea (visibleArea, false);
+
+        return ! visibleArea.isEmpty();
+    }
+
+private:
+
+    // The ComponentMovementWatcher only reports the watched component moving relative to its peer, a parent being
+    // resized, e.g. a panel collapsing to zero size, does not move it. This listener is attached to all parents instead
+    struct ParentListener : public juce::ComponentListener
+    {
+        void componentMovedOrResized (juce::Component&, bool, bool) override
+        {
+            owner->updateVisibility();
+        }
+
+        VisibilityWatcher* owner = nullptr;
+    };
+
+    juce::Component& component;
+    std::function<void (bool)> onVisibilityChanged;
+
+    juce::Array<juce::Component::SafePointer<juce::Component>> parents;
+    ParentListener parentListener;
+
+    bool wasVisible;
+
+    void updateVisibility()
+    {
+        auto isVisible = isVisibleOnScreen (component);
+
+        if (isVisible == wasVisible)
+            return;
+
+        wasVisible = isVisible;
+
+        if (onVisibilityChanged != nullptr)
+            onVisibilityChanged (isVisible);
+    }
+
+    void updateParents()
+    {
+        for (auto& parent : parents)
+            if (parent != nullptr)
+                parent->removeComponentListener (&parentListener);
+
+        parents.clear();
+
+        for (auto* parent = component.getParentComponent(); parent != nullptr; parent = parent->getParentComponent())
+        {
+            parent->addComponentListener (&parentListener);
+            parents.add (parent);
+        }
+    }
+
+    using juce::ComponentMovementWatcher::componentMovedOrResized;
+    using juce::ComponentMovementWatcher::componentVisibilityChanged;
+
+    void componentMovedOrResized (bool, bool) override  { updateVisibility(); }
+    void componentPeerChanged() override                { updateVisibility(); }
+    void componentVisibilityChanged() override          { updateVisibility(); }
+
+    void componentParentHierarchyChanged (juce::Component& c) override
+    {
+        juce::ComponentMovementWatcher::componentParentHierarchyChanged (c);
+
+        updateParents();
+        updateVisibility();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (VisibilityWatcher)
+};
+
+}
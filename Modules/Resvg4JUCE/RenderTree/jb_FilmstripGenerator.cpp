@@ -0,0 +1,309 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "jb_RenderThreadPool.h"
+#include "jb_FilmstripGenerator.h"
+
+#include <resvg.h>
+
+namespace jb
+{
+
+namespace Resvg
+{
+
+// Renders the element with the given id fitted and centred into a frame of the given size in pixels. The frame data
+// is expected to be zero initialised and to have no padding between the lines
+void renderElementInto (resvg_render_tree* tree, const juce::String& id, int frameWidth, int frameHeight, uint8_t* frameData)
+{
+    resvg_rect bbox;
+
+    if (! resvg_get_node_bbox (tree, id.toRawUTF8(), &bbox) || bbox.width <= 0.0 || bbox.height <= 0.0)
+        return;
+
+    juce::Rectangle<float> elementSize (static_cast<float> (frameWidth), static_cast<float> (frameHeight));
+    auto fit = fitInto (static_cast<float> (bbox.width / bbox.height), elementSize);
+
+    const auto w = juce::jmin (frameWidth,  juce::roundToInt (elementSize.getWidth()));
+    const auto h = juce::jmin (frameHeight, juce::roundToInt (elementSize.getHeight()));
+
+    if (w == frameWidth && h == frameHeight)
+    {
+        resvg_render_node (tree, id.toRawUTF8(), fit, static_cast<uint32_t> (w), static_cast<uint32_t> (h), reinterpret_cast<char*> (frameData));
+    }
+    else
+    {
+        // resvg always renders into a buffer without padding between the lines, so an element that doesn't fill the
+        // whole frame is rendered into a temporary buffer first and then copied to the centre of the frame
+        const auto lineSize = static_cast<size_t> (w * bytesPerPixel);
+        juce::HeapBlock<uint8_t> elementData (lineSize * static_cast<size_t> (h), true);
+
+        resvg_render_node (tree, id.toRawUTF8(), fit, static_cast<uint32_t> (w), static_cast<uint32_t> (h), reinterpret_cast<char*> (elementData.get()));
+
+        const auto xOffset = (frameWidth - w) / 2;
+        const auto yOffset = (frameHeight - h) / 2;
+
+        for (int y = 0; y < h; ++y)
+            std::memcpy (frameData + ((y + yOffset) * frameWidth + xOffset) * bytesPerPixel,
+                         elementData + static_cast<size_t> (y) * lineSize,
+                         lineSize);
+    }
+
+    // Red and blue components have to be swapped since resvg orders them differently compared to juce
+    swapRB (frameData, static_cast<int64_t> (frameWidth) * static_cast<int64_t> (frameHeight));
+}
+
+// Wraps the content of the SVG into a group with a transform, so that each frame can be rendered as vectors. The
+// original root element is nested into a new root of the frame size, fitted and centred in it the same way
+// RenderTree::render fits an SVG. The new document is returned as the text before and after the transform value
+// of the group. Returns false if the SVG data can't be parsed as XML
+bool createTransformableDocument (const juce::MemoryBlock& svgData, resvg_size svgSize, int frameWidth, int frameHeight,
+                                  juce::String& documentStart, juce::String& documentEnd)
+{
+    juce::MemoryBlock xmlData (svgData);
+
+    // Compressed svgz files have to be decompressed before they can be parsed as XML
+    if (xmlData.getSize() > 2 && static_cast<uint8_t> (xmlData[0]) == 0x1f && static_cast<uint8_t> (xmlData[1]) == 0x8b)
+    {
+        juce::MemoryInputStream compressed (svgData, false);
+        juce::GZIPDecompressorInputStream decompressor (compressed);
+
+        xmlData.reset();
+        juce::MemoryOutputStream (xmlData, false).writeFromInputStream (decompressor, -1);
+    }
+
+    auto svg = juce::parseXML (xmlData.toString());
+
+    if (svg == nullptr || ! svg->hasTagName ("svg") || svgSize.width <= 0.0 || svgSize.height <= 0.0)
+        return false;
+
+    const auto scale = juce::jmin (frameWidth / svgSize.width, frameHeight / svgSize.height);
+    const auto fittedWidth  = svgSize.width  * scale;
+    const auto fittedHeight = svgSize.height * scale;
+
+    // Without a viewBox, the width and height of the original root define its coordinate system. These are replaced
+    // by the fitted size below, so the coordinate system has to be kept through an explicit viewBox
+    if (! svg->hasAttribute ("viewBox"))
+        svg->setAttribute ("viewBox", "0 0 " + juce::String (svgSize.width) + " " + juce::String (svgSize.height));
+
+    svg->setAttribute ("x", (frameWidth  - fittedWidth)  * 0.5);
+    svg->setAttribute ("y", (frameHeight - fittedHeight) * 0.5);
+    svg->setAttribute ("width",  fittedWidth);
+    svg->setAttribute ("height", fittedHeight);
+
+    juce::XmlElement root ("svg");
+    root.setAttribute ("xmlns", "http://www.w3.org/2000/svg");
+    root.setAttribute ("width",  frameWidth);
+    root.setAttribute ("height", frameHeight);
+
+    auto* group = root.createNewChildElement ("g");
+    group->setAttribute ("transform", "transformPlaceholder");
+    group->addChildElement (svg.release());
+
+    auto document = root.toString (juce::XmlElement::TextFormat().withoutHeader().singleLine());
+
+    documentStart = document.upToFirstOccurrenceOf ("transformPlaceholder", false, false);
+    documentEnd   = document.fromFirstOccurrenceOf ("transformPlaceholder", false, false);
+
+    return true;
+}
+
+juce::String toSVGMatrix (const juce::AffineTransform& t)
+{
+    return "matrix(" + juce::String (t.mat00) + " " + juce::String (t.mat10) + " "
+                     + juce::String (t.mat01) + " " + juce::String (t.mat11) + " "
+                     + juce::String (t.mat02) + " " + juce::String (t.mat12) + ")";
+}
+
+FilmstripGenerator::FilmstripGenerator (const void* data, size_t size, const Options& renderingOptions)
+  : svgData (data, size),
+    options (renderingOptions),
+    tree (renderingOptions)
+{
+    tree.loadFromBinaryData (static_cast<const char*> (svgData.getData()), static_cast<int> (svgData.getSize()));
+}
+
+FilmstripGenerator::FilmstripGenerator (const juce::File& svgFile, const Options& renderingOptions)
+  : options (renderingOptions),
+    tree (renderingOptions)
+{
+    jassert (svgFile.existsAsFile());
+
+    if (svgFile.loadFileAsData (svgData))
+        tree.loadFromBinaryData (static_cast<const char*> (svgData.getData()), static_cast<int> (svgData.getSize()));
+}
+
+bool FilmstripGenerator::isValid()
+{
+    return tree.isValid();
+}
+
+juce::Image FilmstripGenerator::renderTransformed (int numFrames, int frameWidth, int frameHeight,
+                                                   std::function<juce::AffineTransform (int)> transformForFrame)
+{
+    // Before rendering a filmstrip you need to have successfully loaded an SVG
+    jassert (isValid());
+    jassert (numFrames > 0 && frameWidth > 0 && frameHeight > 0);
+
+    juce::String documentStart, documentEnd;
+
+    resvg_size svgSize;
+
+    {
+        const juce::ScopedLock sl (tree.lock);
+        svgSize = resvg_get_image_size ((resvg_render_tree*) tree.tree);
+    }
+
+    if (! createTransformableDocument (svgData, svgSize, frameWidth, frameHeight, documentStart, documentEnd))
+        return renderTransformedResampled (numFrames, frameWidth, frameHeight, transformForFrame);
+
+    juce::Image filmstrip (juce::Image::ARGB, frameWidth, frameHeight * numFrames, true, juce::SoftwareImageType());
+    juce::Image::BitmapData filmstripData (filmstrip, juce::Image::BitmapData::readWrite);
+
+    // Frames are rendered straight into the filmstrip, which only works without padding between the lines
+    jassert (filmstripData.lineStride == frameWidth * bytesPerPixel);
+
+    std::atomic<int> nextFrame { 0 };
+    std::atomic<bool> parsingFailed { false };
+
+    juce::SharedResourcePointer<RenderThreadPool> pool;
+
+    pool->runInParallel (numFrames, [&] (int)
+    {
+        for (auto frame = nextFrame++; frame < numFrames && ! parsingFailed; frame = nextFrame++)
+        {
+            // Each frame has its own transform baked into the document, so each frame needs its own tree
+            auto document = documentStart + toSVGMatrix (transformForFrame (frame)) + documentEnd;
+
+            RenderTree frameTree (options);
+
+            if (! frameTree.loadFromBinaryData (document.toRawUTF8(), static_cast<int> (document.getNumBytesAsUTF8())))
+            {
+                parsingFailed = true;
+                break;
+            }
+
+            auto* frameData = filmstripData.getLinePointer (frame * frameHeight);
+
+            resvg_fit_to fit { RESVG_FIT_TO_ORIGINAL, 1.0f };
+            resvg_render ((resvg_render_tree*) frameTree.tree, fit,
+                          static_cast<uint32_t> (frameWidth), static_cast<uint32_t> (frameHeight),
+                          reinterpret_cast<char*> (frameData));
+
+            // Red and blue components have to be swapped since resvg orders them differently compared to juce
+            swapRB (frameData, static_cast<int64_t> (frameWidth) * static_cast<int64_t> (frameHeight));
+        }
+    });
+
+    // resvg rejected the restructured document, e.g. because it doesn't support nested svg elements the way they are
+    // used here. Rather than returning a filmstrip with empty frames, all frames are resampled instead
+    if (parsingFailed)
+        return renderTransformedResampled (numFrames, frameWidth, frameHeight, transformForFrame);
+
+    return filmstrip;
+}
+
+juce::Image FilmstripGenerator::renderTransformedResampled (int numFrames, int frameWidth, int frameHeight,
+                                                            std::function<juce::AffineTransform (int)> transformForFrame)
+{
+    // Before rendering a filmstrip you need to have successfully loaded an SVG
+    jassert (isValid());
+    jassert (numFrames > 0 && frameWidth > 0 && frameHeight > 0);
+
+    constexpr float oversampling = 2.0f;
+
+    auto image = tree.render (juce::Rectangle<float> (frameWidth * oversampling, frameHeight * oversampling));
+
+    // Scales the oversampled image down to the frame resolution and centres it in the frame
+    auto imageToFrame = juce::AffineTransform::scale (1.0f / oversampling)
+                            .translated ((frameWidth  - image.getWidth()  / oversampling) * 0.5f,
+                                         (frameHeight - image.getHeight() / oversampling) * 0.5f);
+
+    juce::Image filmstrip (juce::Image::ARGB, frameWidth, frameHeight * numFrames, true, juce::SoftwareImageType());
+
+    std::atomic<int> nextFrame { 0 };
+
+    juce::SharedResourcePointer<RenderThreadPool> pool;
+
+    pool->runInParallel (numFrames, [&] (int)
+    {
+        for (auto frame = nextFrame++; frame < numFrames; frame = nextFrame++)
+        {
+            juce::Graphics g (filmstrip.getClippedImage ({ 0, frame * frameHeight, frameWidth, frameHeight }));
+
+            g.setImageResamplingQuality (juce::Graphics::highResamplingQuality);
+            g.drawImageTransformed (image, imageToFrame.followedBy (transformForFrame (frame)));
+        }
+    });
+
+    return filmstrip;
+}
+
+juce::Image FilmstripGenerator::renderRotation (int numFrames, int frameWidth, int frameHeight,
+                                                float startAngleRadians, float endAngleRadians,
+                                                juce::Point<float> relativePivot)
+{
+    const auto pivotX = relativePivot.x * static_cast<float> (frameWidth);
+    const auto pivotY = relativePivot.y * static_cast<float> (frameHeight);
+
+    return renderTransformed (numFrames, frameWidth, frameHeight, [=] (int frame)
+    {
+        auto proportion = numFrames > 1 ? static_cast<float> (frame) / static_cast<float> (numFrames - 1) : 0.0f;
+        auto angle = startAngleRadians + proportion * (endAngleRadians - startAngleRadians);
+
+        return juce::AffineTransform::rotation (angle, pivotX, pivotY);
+    });
+}
+
+juce::Image FilmstripGenerator::renderElements (const juce::StringArray& elementIds, int frameWidth, int frameHeight)
+{
+    // Before rendering a filmstrip you need to have successfully loaded an SVG
+    jassert (isValid());
+    jassert (! elementIds.isEmpty() && frameWidth > 0 && frameHeight > 0);
+
+    const auto numFrames = elementIds.size();
+
+    juce::Image filmstrip (juce::Image::ARGB, frameWidth, frameHeight * numFrames, true, juce::SoftwareImageType());
+    juce::Image::BitmapData filmstripData (filmstrip, juce::Image::BitmapData::readWrite);
+
+    // Frames are rendered straight into the filmstrip, which only works without padding between the lines
+    jassert (filmstripData.lineStride == frameWidth * bytesPerPixel);
+
+    std::atomic<int> nextFrame { 0 };
+
+    juce::SharedResourcePointer<RenderThreadPool> pool;
+
+    pool->runInParallel (numFrames, [&] (int workerIndex)
+    {
+        // The first worker uses the tree of the generator, all others parse their own copy of the SVG
+        std::unique_ptr<RenderTree> ownTree;
+        auto* workerTree = &tree;
+
+        if (workerIndex > 0)
+        {
+            ownTree = std::make_unique<RenderTree> (options);
+
+            if (! ownTree->loadFromBinaryData (static_cast<const char*> (svgData.getData()), static_cast<int> (svgData.getSize())))
+                return;
+
+            workerTree = ownTree.get();
+        }
+
+        const juce::ScopedLock sl (workerTree->lock);
+
+        for (auto frame = nextFrame++; frame < numFrames; frame = nextFrame++)
+            renderElementInto ((resvg_render_tree*) workerTree->tree, elementIds[frame], frameWidth, frameHeight,
+                               filmstripData.getLinePointer (frame * frameHeight));
+    });
+
+    return filmstrip;
+}
+
+}
+}
@@ -0,0 +1,86 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+namespace jb
+{
+
+namespace Resvg
+{
+
+/**
+ * Generates filmstrips, i.e. a single image containing a number of equally sized frames stacked vertically, as used
+ * for knob and meter skins. All frames are rendered in parallel on the RenderThreadPool straight into the filmstrip
+ * image, so that displaying a certain frame later on only needs to blit a part of that image.
+ *
+ * As a resvg tree must not be rendered from multiple threads at the same time, the generator keeps a copy of the
+ * SVG data and parses it once for each thread rendering frames, or once for each frame for transformed frames. Don't
+ * use the generator from a job running on the RenderThreadPool itself.
+ */
+class FilmstripGenerator
+{
+public:
+
+    /** Creates a generator from binary SVG data, parsed with the options passed */
+    FilmstripGenerator (const void* svgData, size_t svgSize, const Options& renderingOptions = {});
+
+    /** Creates a generator from an SVG file, parsed with the options passed */
+    FilmstripGenerator (const juce::File& svgFile, const Options& renderingOptions = {});
+
+    /** Returns true if the SVG passed to the constructor could be parsed */
+    bool isValid();
+
+    /**
+     * Renders numFrames frames of the given size in pixels. For each frame, the whole SVG is fitted into the frame
+     * and the transform returned by transformForFrame is applied to it. The transform is given in frame pixel
+     * coordinates and is called from multiple threads at the same time.
+     *
+     * The resvg C API doesn't accept transforms, so the content of the SVG is wrapped into a group carrying the
+     * transform of the frame and each frame is parsed and rendered as vectors on its own. If the SVG data can't be
+     * restructured that way, e.g. because it uses XML features juce can't parse, or resvg fails to parse any of the
+     * frame documents, the whole filmstrip falls back to renderTransformedResampled.
+     */
+    juce::Image renderTransformed (int numFrames, int frameWidth, int frameHeight,
+                                   std::function<juce::AffineTransform (int frameIndex)> transformForFrame);
+
+    /**
+     * A faster but less accurate version of renderTransformed. The SVG is rendered only once at twice the frame
+     * resolution and the transformed frames are resampled from that image, so thin strokes and edges get blurry at
+     * rotations that aren't a multiple of 90 degrees. Use it for previews or when generating large filmstrips at
+     * runtime takes too long.
+     */
+    juce::Image renderTransformedResampled (int numFrames, int frameWidth, int frameHeight,
+                                            std::function<juce::AffineTransform (int frameIndex)> transformForFrame);
+
+    /**
+     * Renders numFrames frames of the given size in pixels, rotating the SVG from startAngleRadians to endAngleRadians
+     * around a pivot point. The pivot is given relative to the frame size, so the default is the frame centre.
+     */
+    juce::Image renderRotation (int numFrames, int frameWidth, int frameHeight,
+                                float startAngleRadians, float endAngleRadians,
+                                juce::Point<float> relativePivot = { 0.5f, 0.5f });
+
+    /**
+     * Renders one frame per element id, each showing only the element with that id fitted into the frame size.
+     * Frames of elements that don't exist in the SVG stay transparent.
+     */
+    juce::Image renderElements (const juce::StringArray& elementIds, int frameWidth, int frameHeight);
+
+private:
+
+    juce::MemoryBlock svgData;
+    Options options;
+
+    RenderTree tree;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilmstripGenerator)
+};
+
+}
+
+}
@@ -0,0 +1,194 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "jb_PooledImageType.h"
+
+namespace jb
+{
+
+namespace Resvg
+{
+
+thread_local int PixelBufferPool::numEvictionScopes = 0;
+
+PixelBufferPool::~PixelBufferPool()
+{
+    trim();
+}
+
+PixelBufferPool::Block PixelBufferPool::allocate (size_t numBytes)
+{
+    const auto sizeClass = getSizeClass (numBytes);
+
+    {
+        const juce::ScopedLock sl (lock);
+
+        auto blocks = releasedBlocks.find (sizeClass);
+
+        if (blocks != releasedBlocks.end() && ! blocks->second.empty())
+        {
+            auto block = blocks->second.back();
+            blocks->second.pop_back();
+
+            retainedBytes -= block.capacity;
+            return block;
+        }
+    }
+
+    Block block;
+    block.allocation = std::malloc (sizeClass + alignment - 1);
+
+    if (block.allocation == nullptr)
+        throw std::bad_alloc();
+
+    block.data = juce::snapPointerToAlignment (static_cast<uint8_t*> (block.allocation), alignment);
+    block.capacity = sizeClass;
+
+    return block;
+}
+
+void PixelBufferPool::release (Block block)
+{
+    if (numEvictionScopes > 0)
+    {
+        freeBlock (block);
+        return;
+    }
+
+    const juce::ScopedLock sl (lock);
+
+    if (retainedBytes + block.capacity > maxRetainedBytes)
+    {
+        freeBlock (block);
+        return;
+    }
+
+    retainedBytes += block.capacity;
+    releasedBlocks[block.capacity].push_back (block);
+}
+
+void PixelBufferPool::trim()
+{
+    const juce::ScopedLock sl (lock);
+
+    for (auto& sizeClass : releasedBlocks)
+        for (auto& block : sizeClass.second)
+            freeBlock (block);
+
+    releasedBlocks.clear();
+    retainedBytes = 0;
+}
+
+void PixelBufferPool::setMaxRetainedBytes (size_t maxBytes)
+{
+    const juce::ScopedLock sl (lock);
+
+    maxRetainedBytes = maxBytes;
+}
+
+size_t PixelBufferPool::getSizeClass (size_t numBytes)
+{
+    // Size classes are spaced a quarter of the next lower power of two apart, so a block is never more than 25%
+    // bigger than requested
+    size_t powerOfTwo = 1;
+
+    while (powerOfTwo <= numBytes / 2)
+        powerOfTwo <<= 1;
+
+    const auto step = juce::jmax (alignment, powerOfTwo / 4);
+
+    return juce::jmax (step, (numBytes + step - 1) / step * step);
+}
+
+void PixelBufferPool::freeBlock (Block& block)
+{
+    std::free (block.allocation);
+    block = {};
+}
+
+// The pixel data of images created by the PooledImageType, modelled after juce's SoftwareImagePixelData
+class PooledImagePixelData : public juce::ImagePixelData
+{
+public:
+    PooledImagePixelData (juce::Image::PixelFormat format, int w, int h, bool clearImage)
+      : juce::ImagePixelData (format, w, h),
+        pixelStride (format == juce::Image::RGB ? 3 : (format == juce::Image::ARGB ? 4 : 1)),
+        lineStride ((pixelStride * juce::jmax (1, w) + 3) & ~3)
+    {
+        block = pool->allocate (getNumBytes());
+
+        if (clearImage)
+            juce::zeromem (block.data, block.capacity);
+    }
+
+    ~PooledImagePixelData() override
+    {
+        pool->release (block);
+    }
+
+    std::unique_ptr<juce::LowLevelGraphicsContext> createLowLevelContext() override
+    {
+        sendDataChangeMessage();
+        return std::make_unique<juce::LowLevelGraphicsSoftwareRenderer> (juce::Image (*this));
+    }
+
+    void initialiseBitmapData (juce::Image::BitmapData& bitmap, int x, int y, juce::Image::BitmapData::ReadWriteMode mode) override
+    {
+        const auto offset = static_cast<size_t> (x) * static_cast<size_t> (pixelStride) + static_cast<size_t> (y) * static_cast<size_t> (lineStride);
+
+        bitmap.data = block.data + offset;
+        bitmap.size = getNumBytes() - offset;
+        bitmap.pixelFormat = pixelFormat;
+        bitmap.lineStride = lineStride;
+        bitmap.pixelStride = pixelStride;
+
+        if (mode != juce::Image::BitmapData::readOnly)
+            sendDataChangeMessage();
+    }
+
+    juce::ImagePixelData::Ptr clone() override
+    {
+        auto* copy = new PooledImagePixelData (pixelFormat, width, height, false);
+        std::memcpy (copy->block.data, block.data, getNumBytes());
+
+        return juce::ImagePixelData::Ptr (copy);
+    }
+
+    std::unique_ptr<juce::ImageType> createType() const override
+    {
+        return std::make_unique<PooledImageType>();
+    }
+
+private:
+    juce::SharedResourcePointer<PixelBufferPool> pool;
+    PixelBufferPool::Block block;
+
+    const int pixelStride, lineStride;
+
+    size_t getNumBytes() const
+    {
+        return static_cast<size_t> (lineStride) * static_cast<size_t> (juce::jmax (1, height));
+    }
+
+    JUCE_LEAK_DETECTOR (PooledImagePixelData)
+};
+
+juce::ImagePixelData::Ptr PooledImageType::create (juce::Image::PixelFormat format, int width, int height, bool shouldClearImage) const
+{
+    return juce::ImagePixelData::Ptr (new PooledImagePixelData (format, width, height, shouldClearImage));
+}
+
+int PooledImageType::getTypeID() const
+{
+    // Any id distinct from the ones used by the image types that come with juce
+    return 0x6a627069;
+}
+
+}
+}
@@ -0,0 +1,111 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#pragma once
+
+namespace jb
+{
+
+namespace Resvg
+{
+
+/**
+ * A pool of 64 byte aligned memory blocks, used as pixel buffers by the PooledImageType. Blocks are handed out in
+ * size classes spaced a quarter octave apart, blocks that are released are kept and handed out again for requests
+ * of the same size class. This amortises the allocations when many images of similar sizes are created and freed,
+ * e.g. while a window is resized. Access it through a juce::SharedResourcePointer<PixelBufferPool>. All functions
+ * are thread safe.
+ *
+ * Blocks retained by the pool are not returned to the system when the images using them are released, so the pool
+ * only retains a few resize generations worth of buffers by default. Components releasing their rasters because they
+ * are hidden free their own blocks through a ScopedEviction, RasterOwner::releaseAllRasters trims the whole pool.
+ */
+class PixelBufferPool
+{
+public:
+
+    /** The alignment of all blocks. The capacity of all blocks is a multiple of it as well */
+    static constexpr size_t alignment = 64;
+
+    struct Block
+    {
+        uint8_t* data = nullptr;
+        size_t capacity = 0;
+
+        // The address returned by the allocator, data points to the first aligned address within it
+        void* allocation = nullptr;
+    };
+
+    PixelBufferPool() = default;
+
+    ~PixelBufferPool();
+
+    /** Returns a block with a capacity of at least numBytes. The content of the block is undefined */
+    Block allocate (size_t numBytes);
+
+    /**
+     * Returns a block to the pool. The block is freed if the pool already retains the maximum number of bytes or if
+     * a ScopedEviction exists on the calling thread
+     */
+    void release (Block block);
+
+    /**
+     * While an instance exists, all blocks released on the same thread are freed instead of being retained. Use it
+     * around code releasing images whose memory should be returned to the system without affecting the blocks
+     * retained for others.
+     */
+    struct ScopedEviction
+    {
+        ScopedEviction()  { ++numEvictionScopes; }
+        ~ScopedEviction() { --numEvictionScopes; }
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedEviction)
+    };
+
+    /** Frees all blocks currently retained by the pool */
+    void trim();
+
+    /** Sets the maximum number of bytes the pool retains in released blocks. The default is 8 MB */
+    void setMaxRetainedBytes (size_t maxBytes);
+
+private:
+
+    juce::CriticalSection lock;
+
+    std::map<size_t, std::vector<Block>> releasedBlocks;
+
+    size_t retainedBytes = 0;
+
+    static thread_local int numEvictionScopes;
+    size_t maxRetainedBytes = 8 * 1024 * 1024;
+
+    static size_t getSizeClass (size_t numBytes);
+    static void freeBlock (Block& block);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PixelBufferPool)
+};
+
+/**
+ * A software image type that stores its pixels in blocks of the PixelBufferPool. The pixel data of these images
+ * starts at a 64 byte aligned address, has no padding between lines for ARGB and SingleChannel images and the block
+ * holding it is padded to a multiple of 64 bytes. Used by RenderTree for all images it renders if the native image
+ * type creates software images, i.e. not with CoreGraphics or Direct2D.
+ */
+class PooledImageType : public juce::ImageType
+{
+public:
+
+    juce::ImagePixelData::Ptr create (juce::Image::PixelFormat format, int width, int height, bool shouldClearImage) const override;
+
+    int getTypeID() const override;
+};
+
+}
+
+}
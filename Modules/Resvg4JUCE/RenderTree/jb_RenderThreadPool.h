@@ -0,0 +1,62 @@
+/*
+This file is part of Resvg4JUCE.
+
+This Source Code Form is subject to the terms of the Mozilla Public
+License, v. 2.0. If a copy of the MPL was not distributed with this
+file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#pragma once
+
+namespace jb
+{
+
+namespace Resvg
+{
+
+/**
+ * The thread pool used for all background rendering done by this module. Access it through a
+ * juce::SharedResourcePointer<RenderThreadPool>, the pool is created when the first pointer is created and deleted
+ * together with the last one. It uses one thread per CPU core.
+ */
+class RenderThreadPool : public juce::ThreadPool
+{
+public:
+    RenderThreadPool() : juce::ThreadPool (juce::SystemStats::getNumCpus()) {}
+
+    /**
+     * Runs the work function on up to maxNumWorkers threads of the pool and blocks until all of them are done. The
+     * work function is called with the index of the worker. Must not be called from a job running on this pool.
+     */
+    void runInParallel (int maxNumWorkers, const std::function<void (int workerIndex)>& work)
+    {
+        const auto numWorkers = juce::jmin (maxNumWorkers, getNumThreads());
+
+        if (numWorkers <= 0)
+            return;
+
+        juce::WaitableEvent allFinished;
+        std::atomic<int> numRunning { numWorkers };
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            addJob ([&, i]
+            {
+                work (i);
+
+                if (--numRunning == 0)
+                    allFinished.signal();
+            });
+        }
+
+        allFinished.wait();
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (RenderThreadPool)
+};
+
+}
+
+}
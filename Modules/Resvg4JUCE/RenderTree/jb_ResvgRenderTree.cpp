@@ -8,6 +8,7 @@ file, You can obtain one at http://mozilla.org/MPL/2.0/.
 */
 
 #include "jb_ResvgRenderTree.h"
+#include "jb_PooledImageType.h"
 
 #if JUCE_INTEL
 #include "immintrin.h"
@@ -105,13 +106,51 @@ void swapRB (uint8_t* data, int64_t numBytes)
     swapRBSSE (data, numBytes);
 }
 
+// Swaps the red and blue component of pixel data that starts at a 16 byte aligned address and is padded to a multiple
+// of 16 bytes, like all images created by the PooledImageType. The padding bytes are shuffled as well, which allows
+// processing all pixels with SIMD instructions without any scalar loop before or after
+void swapRBAligned (uint8_t* data, int64_t numPixel)
+{
+    jassert (juce::snapPointerToAlignment (data, sizeof (__m128i)) == data);
+
+    const auto numVectors = (numPixel * bytesPerPixel + int (sizeof (__m128i)) - 1) / int (sizeof (__m128i));
+    auto* vectors = reinterpret_cast<__m128i*> (data);
+
+    __m128i shuffleMask = _mm_set_epi8 (15, 12, 13, 14,
+                                        11, 8,  9, 10,
+                                        7,  4,  5,  6,
+                                        3,  0,  1,  2);
+
+    for (int64_t i = 0; i < numVectors; ++i)
+        _mm_store_si128 (vectors + i, _mm_shuffle_epi8 (_mm_load_si128 (vectors + i), shuffleMask));
+}
+
 #else
 void swapRB (uint8_t* data, int64_t numBytes)
 {
     swapRBnonSIMD (data, numBytes);
 }
+
+void swapRBAligned (uint8_t* data, int64_t numPixel)
+{
+    swapRBnonSIMD (data, numPixel);
+}
 #endif
 
+// Renderers with their own native images, like CoreGraphics or Direct2D, copy or upload the pixels of software images
+// each time they are drawn, so the PooledImageType is only used where native images are software images anyway. All
+// native image types report the same id, so this looks at the type of the pixel data a native image is created with
+bool usePooledImages()
+{
+    static const bool nativeImagesAreSoftwareImages = []
+    {
+        juce::Image nativeImage (juce::Image::ARGB, 1, 1, false, juce::NativeImageType());
+        return nativeImage.getPixelData()->createType()->getTypeID() == juce::SoftwareImageType().getTypeID();
+    }();
+
+    return nativeImagesAreSoftwareImages;
+}
+
 // Internal function to perform the actual rendering behind the various RenderTree::render functions
 juce::Image renderTree (resvg_render_tree* tree, resvg_fit_to fit, juce::Colour backgroundColour, juce::Rectangle<int>&& imageBounds)
 {
@@ -121,7 +160,10 @@ juce::Image renderTree (resvg_render_tree* tree, resvg_fit_to fit, juce::Colour
     const auto h = imageBounds.getHeight();
     const auto w = imageBounds.getWidth();
 
-    juce::Image image (juce::Image::PixelFormat::ARGB, w, h, backgroundColour.isTransparent());
+    // Pooled images avoid allocating new pixel buffers for each render and are always aligned for swapRBAligned
+    juce::Image image (juce::Image::PixelFormat::ARGB, w, h, backgroundColour.isTransparent(),
+                       usePooledImages() ? static_cast<const juce::ImageType&> (PooledImageType())
+                                       : static_cast<const juce::ImageType&> (juce::NativeImageType()));
 
     image.clear (imageBounds, swapRB (backgroundColour));
 
@@ -133,7 +175,10 @@ juce::Image renderTree (resvg_render_tree* tree, resvg_fit_to fit, juce::Colour
                   reinterpret_cast<char*> (dstData.data));
 
     // Red and blue components have to be swapped since resvg orders them differently compared to juce
-    swapRB (dstData.data, static_cast<int64_t> (w) * static_cast<int64_t> (h));
+    if (usePooledImages())
+        swapRBAligned (dstData.data, static_cast<int64_t> (w) * static_cast<int64_t> (h));
+    else
+        swapRB (dstData.data, static_cast<int64_t> (w) * static_cast<int64_t> (h));
 
     return image;
 }
@@ -154,6 +199,34 @@ juce::Image renderTree (resvg_render_tree* tree, resvg_fit_to fit, juce::Colour
     return renderTree (tree, fit, backgroundColour, juce::Rectangle<double> (imageSize.width, imageSize.height).toNearestIntEdges());
 }
 
+// Internal function to compute the fit that scales content with the source aspect ratio to fit into the destination
+// size while preserving the aspect ratio. The destination size is adjusted to the resulting image size
+resvg_fit_to fitInto (float srcAspectRatio, juce::Rectangle<float>& dstSize)
+{
+    auto dstAspectRatio = dstSize.getAspectRatio();
+
+    resvg_fit_to fit;
+    if (srcAspectRatio < dstAspectRatio)
+    {
+        // The source image is wider than the destination image --> fit to height
+        fit.type = RESVG_FIT_TO_HEIGHT;
+        fit.value = dstSize.getHeight();
+
+        dstSize.setWidth (fit.value * srcAspectRatio);
+    }
+    else
+    {
+        fit.type = RESVG_FIT_TO_WIDTH;
+        fit.value = dstSize.getWidth();
+
+        dstSize.setHeight (fit.value / srcAspectRatio);
+    }
+
+    jassert (fit.value >= 1.0f);
+
+    return fit;
+}
+
 void initLog()
 {
     resvg_init_log();
@@ -197,6 +270,8 @@ RenderTree::~RenderTree ()
 
 bool RenderTree::loadFromFile (const juce::File& svgFile)
 {
+    const juce::ScopedLock sl (lock);
+
     jassert (svgFile.existsAsFile());
     auto fullPath = svgFile.getFullPathName();
 
@@ -216,6 +291,8 @@ bool RenderTree::loadFromFile (const juce::File& svgFile)
 
 bool RenderTree::loadFromBinaryData (const char* data, int size)
 {
+    const juce::ScopedLock sl (lock);
+
     if (tree != nullptr)
         resvg_tree_destroy ((resvg_render_tree*) tree);
 
@@ -232,11 +309,15 @@ bool RenderTree::loadFromBinaryData (const char* data, int size)
 
 bool RenderTree::isValid()
 {
+    const juce::ScopedLock sl (lock);
+
     return tree != nullptr;
 }
 
 juce::Rectangle<int> RenderTree::getSize()
 {
+    const juce::ScopedLock sl (lock);
+
     if (tree == nullptr)
         return {};
 
@@ -247,6 +328,8 @@ juce::Rectangle<int> RenderTree::getSize()
 
 float RenderTree::getAspectRatio()
 {
+    const juce::ScopedLock sl (lock);
+
     if (tree == nullptr)
         return -1.0f;
 
@@ -257,39 +340,27 @@ float RenderTree::getAspectRatio()
 
 juce::Image RenderTree::render (juce::Colour backgroundColour)
 {
+    const juce::ScopedLock sl (lock);
+
     resvg_fit_to fit { resvg_fit_to_type::RESVG_FIT_TO_ORIGINAL, 1.0f };
     return renderTree ((resvg_render_tree*) tree, fit, backgroundColour);
 }
 
 juce::Image RenderTree::render (float zoomFactor, juce::Colour backgroundColour)
 {
+    const juce::ScopedLock sl (lock);
+
     resvg_fit_to fit { resvg_fit_to_type::RESVG_FIT_TO_ZOOM, zoomFactor };
     return renderTree ((resvg_render_tree*) tree, fit, backgroundColour);
 }
 
 juce::Image RenderTree::render (juce::Rectangle<float> dstSize, juce::Colour backgroundColour)
 {
-    auto dstAspectRatio = dstSize.getAspectRatio();
-    auto srcAspectRatio = getAspectRatio();
+    const juce::ScopedLock sl (lock);
 
-    resvg_fit_to fit;
-    if (srcAspectRatio < dstAspectRatio)
-    {
-        // The source image is wider than the destination image --> fit to height
-        fit.type = RESVG_FIT_TO_HEIGHT;
-        fit.value = dstSize.getHeight();
-
-        dstSize.setWidth (fit.value * srcAspectRatio);
-    }
-    else
-    {
-        fit.type = RESVG_FIT_TO_WIDTH;
-        fit.value = dstSize.getWidth();
-
-        dstSize.setHeight (fit.value / srcAspectRatio);
-    }
+    auto srcAspectRatio = getAspectRatio();
 
-    jassert (fit.value >= 1.0f);
+    auto fit = fitInto (srcAspectRatio, dstSize);
 
     return renderTree ((resvg_render_tree*) tree, fit, backgroundColour, dstSize.toNearestIntEdges());
 }
@@ -57,7 +57,7 @@ void initLog();
 /**
  * This class encapsulates an resvg_render_tree and gives you functions to load svg files into it and render them
  * to a juce::Image. Once you have loaded an svg into the tree, you can call render multiple times without re-loading
- * the svg.
+ * the svg. All member functions may be called from any thread, concurrent calls on the same tree are serialized.
  */
 class RenderTree
 {
@@ -118,6 +118,11 @@ private:
     void* options = nullptr;
     void *tree = nullptr;
 
+    // resvg trees must not be accessed from multiple threads at the same time
+    juce::CriticalSection lock;
+
+    friend class FilmstripGenerator;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderTree)
 };
 
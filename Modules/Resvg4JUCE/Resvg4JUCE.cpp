@@ -8,3 +8,5 @@ file, You can obtain one at http://mozilla.org/MPL/2.0/.
 */
 
 #include "RenderTree/jb_ResvgRenderTree.cpp"
+#include "RenderTree/jb_PooledImageType.cpp"
+#include "RenderTree/jb_FilmstripGenerator.cpp"
@@ -34,6 +34,28 @@ file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #pragma once
 
+/** Config: JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS
+    The maximum number of shapes for a document to be drawn as vectors by jb::SVGComponent::Backend::automatic. Set it
+    to the value the BackendBenchmark example suggests for your target machines. No measured default ships with the
+    module yet, so unless it is set, automatic mode only draws documents without any shapes as vectors and renders
+    everything else through resvg, just like the raster backend.
+*/
+#ifndef JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS
+ #define JB_SVG_MAX_NUM_SHAPES_FOR_VECTORS 0
+#endif
+
 #include "RenderTree/jb_ResvgRenderTree.h"
+#include "RenderTree/jb_RenderThreadPool.h"
+#include "RenderTree/jb_PooledImageType.h"
+#include "RenderTree/jb_FilmstripGenerator.h"
+#include "Components/jb_RasterCache.h"
+#include "Components/jb_DisplayScaleWatcher.h"
+#include "Components/jb_RasterOwner.h"
+#include "Components/jb_VisibilityWatcher.h"
+#include "Components/jb_ComponentRasterOwner.h"
+#include "Components/jb_SVGComplexity.h"
+#include "Components/jb_SVGPrewarmer.h"
 #include "Components/jb_SVGComponent.h"
 #include "Components/jb_SVGButton.h"
+#include "Components/jb_FilmstripComponent.h"
+#include "Components/jb_SVGDrawable.h"